@@ -0,0 +1,159 @@
+#include "input.h"
+
+#include <stdio.h>
+
+#include "buttons.h"
+#include "interrupts.h"
+#include "intervalTimer.h"
+
+#define INPUT_TIMER INTERVAL_TIMER_2
+#define INPUT_TIMER_IRQ INTERVAL_TIMER_2_INTERRUPT_IRQ
+
+#define QUEUE_SIZE 64 // Must be a power of two
+#define QUEUE_MASK (QUEUE_SIZE - 1)
+
+#define NO_PENDING_EVENT UINT32_MAX
+
+typedef struct {
+  uint8_t buttons; // State of all buttons after the change
+  uint32_t sample; // Sample the change was seen on
+} input_event_t;
+
+// Single-producer/single-consumer ring. Only the interrupt writes `head` and
+// only `input_poll` writes `tail`, so neither needs a lock; the barriers keep
+// an event's contents from being reordered past the index that publishes it.
+static input_event_t queue[QUEUE_SIZE];
+static volatile uint16_t head = 0;
+static volatile uint16_t tail = 0;
+static volatile uint32_t samples = 0;
+static volatile uint32_t deferred_events = 0;
+static uint8_t isr_buttons = 0;
+
+// Consumer side
+static uint8_t poll_buttons = 0;
+static uint32_t poll_sample = 0;
+
+// Latency from the oldest unanswered press to the next column sent to the
+// display.
+static uint32_t pending_press = NO_PENDING_EVENT;
+static uint32_t latency_count = 0;
+static uint32_t latency_total = 0;
+static uint32_t latency_max = 0;
+static uint32_t unseen_presses = 0; // Presses that changed nothing on screen
+
+static void input_isr() {
+  intervalTimer_ackInterrupt(INPUT_TIMER);
+  uint32_t sample = ++samples;
+
+  uint8_t buttons = buttons_read();
+  if (buttons == isr_buttons)
+    return;
+
+  // A change that does not fit is seen again on the next sample, rather than
+  // leaving `input_poll` with a button stuck down.
+  uint16_t h = head;
+  if (((h + 1) & QUEUE_MASK) == tail) {
+    deferred_events++;
+    return;
+  }
+
+  queue[h].buttons = buttons;
+  queue[h].sample = sample;
+  __sync_synchronize();
+  head = (h + 1) & QUEUE_MASK;
+  isr_buttons = buttons;
+}
+
+void input_init() {
+  intervalTimer_initCountDown(INPUT_TIMER, 1.0 / INPUT_SAMPLE_HZ);
+  intervalTimer_enableInterrupt(INPUT_TIMER);
+  interrupts_register(INPUT_TIMER_IRQ, input_isr);
+  interrupts_irq_enable(INPUT_TIMER_IRQ);
+  intervalTimer_start(INPUT_TIMER);
+}
+
+static void add_held(input_t *input, uint32_t until) {
+  uint32_t duration = until - poll_sample;
+  for (uint8_t i = 0; i < INPUT_BUTTON_COUNT; i++) {
+    if (!(poll_buttons & (1 << i)))
+      continue;
+
+    uint32_t held = input->held[i] + duration;
+    input->held[i] = (held > UINT16_MAX) ? UINT16_MAX : held;
+  }
+  poll_sample = until;
+}
+
+// Fills `input` with how long each button was held since the last call.
+void input_poll(input_t *input) {
+  for (uint8_t i = 0; i < INPUT_BUTTON_COUNT; i++)
+    input->held[i] = 0;
+
+  // Everything sampled up to `now` is already in the queue, since the
+  // interrupt counts a sample and queues its change in one go.
+  uint32_t now = samples;
+
+  uint16_t t = tail, h = head;
+  __sync_synchronize();
+  while (t != h && queue[t].sample <= now) {
+    input_event_t event = queue[t];
+    t = (t + 1) & QUEUE_MASK;
+
+    bool pressed = event.buttons & ~poll_buttons;
+    if (pressed && pending_press == NO_PENDING_EVENT)
+      pending_press = event.sample;
+
+    add_held(input, event.sample);
+    poll_buttons = event.buttons;
+  }
+  tail = t;
+
+  add_held(input, now);
+}
+
+// Prints the latencies once enough presses have been timed. Called outside
+// the timed part of a frame, since printing to the console is slow.
+void input_report_latency() {
+  if (latency_count < INPUT_LATENCY_REPORT_EVERY)
+    return;
+
+  printf("Input latency: avg %ld ms, max %ld ms",
+         (long)(latency_total * 1000 / INPUT_SAMPLE_HZ / latency_count),
+         (long)(latency_max * 1000 / INPUT_SAMPLE_HZ));
+  if (unseen_presses)
+    printf(", %ld presses changed nothing", (long)unseen_presses);
+  if (deferred_events)
+    printf(", %ld events deferred", (long)deferred_events);
+  printf("\n");
+
+  latency_count = 0;
+  latency_total = 0;
+  latency_max = 0;
+  unseen_presses = 0;
+}
+
+// Called after each column that changed on screen is drawn, so the first call
+// after a press marks when its effect first reached the display.
+void input_column_flushed() {
+  if (pending_press == NO_PENDING_EVENT)
+    return;
+
+  uint32_t latency = samples - pending_press;
+  pending_press = NO_PENDING_EVENT;
+
+  latency_count++;
+  latency_total += latency;
+  if (latency > latency_max)
+    latency_max = latency;
+}
+
+// Called once each frame has been sent to the display. A press the frame
+// answered without changing a column is not timed, since the next column that
+// changes may have nothing to do with it.
+void input_frame_flushed() {
+  if (pending_press == NO_PENDING_EVENT)
+    return;
+
+  pending_press = NO_PENDING_EVENT;
+  unseen_presses++;
+}
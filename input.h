@@ -0,0 +1,36 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The buttons are sampled by a timer interrupt at this rate. Every change is
+// queued with the sample it happened on, so presses shorter than a frame are
+// not lost and `move` knows how long each button was actually held.
+#define INPUT_SAMPLE_HZ 1000
+#define INPUT_BUTTON_COUNT 4
+
+// Index into `input_t::held` of each button
+#define INPUT_BTN0 0
+#define INPUT_BTN1 1
+#define INPUT_BTN2 2
+#define INPUT_BTN3 3
+
+// Print the average and worst input latency after this many measurements.
+#define INPUT_LATENCY_REPORT_EVERY 20
+
+typedef struct {
+  // Samples each button was held for since the last `input_poll`
+  uint16_t held[INPUT_BUTTON_COUNT];
+} input_t;
+
+#define INPUT_HELD_SECONDS(input, button)                                      \
+  ((double)(input)->held[button] / INPUT_SAMPLE_HZ)
+
+void input_init();
+void input_poll(input_t *input);
+void input_column_flushed();
+void input_frame_flushed();
+void input_report_latency();
+
+#endif
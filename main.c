@@ -2,31 +2,40 @@
 
 #include "buttons.h"
 #include "display.h"
+#include "interrupts.h"
 #include "intervalTimer.h"
 
 #include "angles.h"
 #include "error.h"
+#include "input.h"
 #include "renderer.h"
+#include "scene.h"
+#include "trace.h"
 
 #define COUNT_OF(x)                                                            \
   ((sizeof(x) / sizeof(0 [x])) / ((size_t)(!(sizeof(x) % sizeof(0 [x])))))
 
 static void draw_to_screen(drawing_t *drawing, drawing_t *last) {
   for (uint16_t x = 0; x < FRAME_WIDTH; x++) {
+    bool changed = false;
     for (uint16_t y = 0; y < FRAME_HEIGHT; y++) {
       if (drawing->pixels[x][y] != last->pixels[x][y]) {
         display_drawPixel(x, y, drawing->pixels[x][y]);
+        changed = true;
       }
     }
+
+    if (changed)
+      input_column_flushed();
   }
+  input_frame_flushed();
 }
 
 drawing_t drawing1, drawing2;
 bool last_used_drawing1 = false;
 
-#define P(X, Y)                                                                \
-  { .x = REAL_TO_FIXP(X), .y = REAL_TO_FIXP(Y) }
-render_point_t cube[] = {
+#define P(X, Y) MAP_POINT(X, Y)
+map_point_t cube[] = {
     // {.x = INT_TO_FIXP(1), .y = INT_TO_FIXP(1)},
     // {.x = INT_TO_FIXP(1), .y = INT_TO_FIXP(2)},
     // {.x = INT_TO_FIXP(2), .y = INT_TO_FIXP(2)},
@@ -34,9 +43,9 @@ render_point_t cube[] = {
     // {.x = INT_TO_FIXP(1), .y = INT_TO_FIXP(1)},
     P(1, 1), P(1, 2), P(2, 2), P(2, 1), P(1, 1)};
 
-render_point_t triangle[] = {P(-2, 1), P(-1, 1), P(-1.5, 2), P(-2, 1)};
+map_point_t triangle[] = {P(-2, 1), P(-1, 1), P(-1.5, 2), P(-2, 1)};
 
-render_point_t circle[] = {
+map_point_t circle[] = {
     P(-1.0, 2.0),     P(-1.022, 2.208), P(-1.086, 2.407), P(-1.191, 2.588),
     P(-1.331, 2.743), P(-1.5, 2.866),   P(-1.691, 2.951), P(-1.895, 2.995),
     P(-2.105, 2.995), P(-2.309, 2.951), P(-2.5, 2.866),   P(-2.669, 2.743),
@@ -46,24 +55,266 @@ render_point_t circle[] = {
     P(-1.691, 1.049), P(-1.5, 1.134),   P(-1.331, 1.257), P(-1.191, 1.412),
     P(-1.086, 1.593), P(-1.022, 1.792), P(-1.0, 2.0)};
 
-render_point_t maze1[] = {P(-1, -4), P(-1, -2), P(-2, -2), P(-2, -6),
+map_point_t maze1[] = {P(-1, -4), P(-1, -2), P(-2, -2), P(-2, -6),
                           P(0, -6),  P(0, -3),  P(1, -3)};
-render_point_t maze2[] = {P(-2, -5), P(-1, -5)};
-render_point_t maze3[] = {P(0, -2), P(2, -2), P(2, -6), P(1, -6), P(1, -5)};
-render_point_t maze4[] = {P(2, -4), P(1, -4)};
+map_point_t maze2[] = {P(-2, -5), P(-1, -5)};
+map_point_t maze3[] = {P(0, -2), P(2, -2), P(2, -6), P(1, -6), P(1, -5)};
+map_point_t maze4[] = {P(2, -4), P(1, -4)};
 
-#define RENDER(shape) renderer_render_polygon(&frame, shape, COUNT_OF(shape));
+// All the walls of the map. With RENDERER_GRID, the ones along whole grid lines
+// are also kept in `level`, which leaves out the circle.
+scene_t scene;
 
-static void draw_all(fixp_t x, fixp_t y, fixp_t a) {
-  frame_t frame;
-  renderer_init_frame(&frame, x, y, a);
+#define LEVEL_WIDTH 4
+#define LEVEL_HEIGHT 8
+uint8_t level_cells[GRID_CELLS(LEVEL_WIDTH, LEVEL_HEIGHT)];
+grid_map_t level = {.origin_x = -2,
+                    .origin_y = -6,
+                    .width = LEVEL_WIDTH,
+                    .height = LEVEL_HEIGHT,
+                    .cells = level_cells};
+
+#define SCENE_ADD(shape) scene_add_static(&scene, shape, COUNT_OF(shape));
+
+static void build_level() {
+  renderer_grid_clear(&level);
+#ifdef RENDERER_GRID
+  scene_init(&scene, &level);
+#else
+  // Nothing draws the grid, so the scene need not keep it up to date.
+  scene_init(&scene, NULL);
+#endif
+  SCENE_ADD(cube);
+  SCENE_ADD(circle);
+  SCENE_ADD(maze1);
+  SCENE_ADD(maze2);
+  SCENE_ADD(maze3);
+  SCENE_ADD(maze4);
+}
+
+static void render_all(frame_t *frame, map_point_t *camera, fixp_t a) {
+  renderer_init_frame(frame, camera, a);
+  scene_render(&scene, frame);
+}
+
+// Uncomment this line to time both renderers on the grid level, from the same
+// poses, and scene updates against scenes of different sizes before starting.
+// #define RENDERER_BENCHMARK
+
+#ifdef RENDERER_BENCHMARK
+#define BENCHMARK_ROUNDS 10
+#define BENCHMARK_ANGLES 16
+#define BENCHMARK_SCENE_UPDATES 100
+
+#define RENDER(shape) renderer_render_polygon(frame, shape, COUNT_OF(shape));
+
+map_point_t benchmark_poses[] = {P(0, 0), P(-1.5, -3), P(0.5, -4.5),
+                                 P(1.5, -2.5)};
+
+// Poses for checking patched frames, including some right up against walls
+map_point_t patch_poses[] = {P(0, 0),       P(-1.5, -3),     P(0.5, -4.5),
+                             P(1.5, -2.5),  P(-1.02, -3.02), P(0.02, -5.5),
+                             P(1.98, -2.02), P(0.5, 0.98)};
+
+#define GRID_ADD(shape)                                                        \
+  renderer_grid_add_polygon(&level, shape, COUNT_OF(shape));
+
+// The scene only fills `level` with RENDERER_GRID, so the benchmark fills it
+// itself otherwise.
+static void build_benchmark_grid() {
+#ifndef RENDERER_GRID
+  GRID_ADD(cube);
+  GRID_ADD(maze1);
+  GRID_ADD(maze2);
+  GRID_ADD(maze3);
+  GRID_ADD(maze4);
+#endif
+}
+
+static void render_level_segments(frame_t *frame) {
   RENDER(cube);
-  RENDER(circle);
   RENDER(maze1);
   RENDER(maze2);
   RENDER(maze3);
   RENDER(maze4);
+}
 
+// Renders every benchmark pose with the given renderer, and returns the
+// average time per frame in seconds.
+static double benchmark_renderer(bool grid, frame_t frames[]) {
+  intervalTimer_reload(INTERVAL_TIMER_0);
+  for (uint16_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+    uint16_t f = 0;
+    for (uint16_t p = 0; p < COUNT_OF(benchmark_poses); p++) {
+      for (uint16_t i = 0; i < BENCHMARK_ANGLES; i++, f++) {
+        frame_t *frame = &frames[f];
+        renderer_init_frame(frame, &benchmark_poses[p],
+                            (PI_2 / BENCHMARK_ANGLES) * i);
+        if (grid)
+          renderer_render_grid(frame, &level);
+        else
+          render_level_segments(frame);
+      }
+    }
+  }
+  double total = intervalTimer_getTotalDurationInSeconds(INTERVAL_TIMER_0);
+  return total / (BENCHMARK_ROUNDS * COUNT_OF(benchmark_poses) *
+                  BENCHMARK_ANGLES);
+}
+
+static map_point_t benchmark_point(fixp_t x, fixp_t y) {
+  map_point_t point = {.tile_x = 0, .tile_y = 0, .x = x, .y = y};
+  renderer_normalize_point(&point);
+  return point;
+}
+
+// Fills a scene with rows of short walls in front of the camera, then times
+// moving one wall at a time and patching the frame against rendering it all.
+static void benchmark_scene_updates(uint16_t walls) {
+  static scene_t bench_scene;
+  scene_init(&bench_scene, NULL);
+
+  for (uint16_t i = 0; i < walls; i++) {
+    fixp_t x = INT_TO_FIXP(2 + i / 16), y = INT_TO_FIXP((i % 16) - 8);
+    map_point_t p1 = benchmark_point(x, y);
+    map_point_t p2 = benchmark_point(x, y + INT_TO_FIXP(1) / 2);
+    scene_add_wall(&bench_scene, &p1, &p2);
+  }
+
+  map_point_t camera = MAP_POINT(0, 0);
+  frame_t frame, check;
+
+  intervalTimer_reload(INTERVAL_TIMER_0);
+  for (uint16_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+    renderer_init_frame(&frame, &camera, 0);
+    scene_render(&bench_scene, &frame);
+  }
+  double render_time =
+      intervalTimer_getTotalDurationInSeconds(INTERVAL_TIMER_0) /
+      BENCHMARK_ROUNDS;
+  scene_clear_changes(&bench_scene);
+
+  intervalTimer_reload(INTERVAL_TIMER_0);
+  for (uint16_t u = 0; u < BENCHMARK_SCENE_UPDATES; u++) {
+    scene_handle_t handle = u % walls;
+    scene_wall_t *wall = &bench_scene.walls[bench_scene.slots[handle]];
+    fixp_t shift = (u / walls % 2) ? -INT_TO_FIXP(1) / 4 : INT_TO_FIXP(1) / 4;
+    map_point_t p1 = wall->points[0], p2 = wall->points[1];
+    p1.y += shift;
+    p2.y += shift;
+    renderer_normalize_point(&p1);
+    renderer_normalize_point(&p2);
+
+    scene_move_wall(&bench_scene, handle, &p1, &p2);
+    scene_patch_frame(&bench_scene, &frame);
+    scene_clear_changes(&bench_scene);
+  }
+  double update_time =
+      intervalTimer_getTotalDurationInSeconds(INTERVAL_TIMER_0) /
+      BENCHMARK_SCENE_UPDATES;
+
+  renderer_init_frame(&check, &camera, 0);
+  scene_render(&bench_scene, &check);
+  bool matches = renderer_hash_frame(&frame) == renderer_hash_frame(&check);
+
+  printf("%d walls: %f ms per update, %f ms per full render%s\n", walls,
+         update_time * 1000, render_time * 1000,
+         matches ? "" : " (patched frame differs!)");
+}
+
+static uint32_t check_patch(frame_t *frame, map_point_t *camera, fixp_t a) {
+  frame_t full;
+  scene_patch_frame(&scene, frame);
+  scene_clear_changes(&scene);
+  render_all(&full, camera, a);
+  return renderer_hash_frame(frame) != renderer_hash_frame(&full);
+}
+
+#define LEVEL_X_EDGES ((LEVEL_WIDTH + 1) * LEVEL_HEIGHT)
+#define LEVEL_EDGES (LEVEL_X_EDGES + LEVEL_WIDTH * (LEVEL_HEIGHT + 1))
+
+// Finds the ends of one of the unit edges of the level's grid, counting the
+// ones along x lines first.
+static void level_edge(uint16_t edge, map_point_t *p1, map_point_t *p2) {
+  int16_t x, y, dx = 0, dy = 0;
+  if (edge < LEVEL_X_EDGES) {
+    x = level.origin_x + edge % (LEVEL_WIDTH + 1);
+    y = level.origin_y + edge / (LEVEL_WIDTH + 1);
+    dy = 1;
+  } else {
+    edge -= LEVEL_X_EDGES;
+    x = level.origin_x + edge % LEVEL_WIDTH;
+    y = level.origin_y + edge / LEVEL_WIDTH;
+    dx = 1;
+  }
+  *p1 = benchmark_point(INT_TO_FIXP(x), INT_TO_FIXP(y));
+  *p2 = benchmark_point(INT_TO_FIXP(x + dx), INT_TO_FIXP(y + dy));
+}
+
+// Puts a door on each edge of the level's grid in turn, moves it to the next
+// edge and takes it out again, patching a frame from every pose. Doors on the
+// maze's own walls check that those stay in the grid. Counts the patched
+// frames that differ from a full render.
+static void check_scene_patches() {
+  uint32_t checked = 0, different = 0;
+  for (uint16_t p = 0; p < COUNT_OF(patch_poses); p++) {
+    for (uint16_t i = 0; i < BENCHMARK_ANGLES; i++) {
+      fixp_t a = (PI_2 / BENCHMARK_ANGLES) * i;
+      frame_t frame;
+      render_all(&frame, &patch_poses[p], a);
+
+      for (uint16_t edge = 0; edge < LEVEL_EDGES; edge++) {
+        map_point_t p1, p2;
+        level_edge(edge, &p1, &p2);
+        scene_handle_t door = scene_add_wall(&scene, &p1, &p2);
+        different += check_patch(&frame, &patch_poses[p], a);
+
+        level_edge((edge + 1) % LEVEL_EDGES, &p1, &p2);
+        scene_move_wall(&scene, door, &p1, &p2);
+        different += check_patch(&frame, &patch_poses[p], a);
+
+        scene_remove_wall(&scene, door);
+        different += check_patch(&frame, &patch_poses[p], a);
+        checked += 3;
+      }
+    }
+  }
+
+  printf("%ld of %ld patched frames differ from a full render\n",
+         (long)different, (long)checked);
+}
+
+static void benchmark() {
+  static frame_t segment_frames[COUNT_OF(benchmark_poses) * BENCHMARK_ANGLES];
+  static frame_t grid_frames[COUNT_OF(benchmark_poses) * BENCHMARK_ANGLES];
+
+  build_benchmark_grid();
+  double segment_time = benchmark_renderer(false, segment_frames);
+  double grid_time = benchmark_renderer(true, grid_frames);
+
+  // Columns more than a pixel apart, as a check that both drew the same level
+  uint32_t different = 0;
+  for (uint16_t f = 0; f < COUNT_OF(segment_frames); f++) {
+    for (uint16_t x = 0; x < FRAME_WIDTH; x++) {
+      if (abs(FIXP_TO_INT(segment_frames[f].heights[x]) -
+              FIXP_TO_INT(grid_frames[f].heights[x])) > 1)
+        different++;
+    }
+  }
+
+  printf("Segment renderer: %f ms per frame\n", segment_time * 1000);
+  printf("Grid renderer: %f ms per frame\n", grid_time * 1000);
+  printf("%ld of %ld columns differ\n", (long)different,
+         (long)(COUNT_OF(segment_frames) * FRAME_WIDTH));
+
+  check_scene_patches();
+  for (uint16_t walls = 16; walls <= SCENE_MAX_WALLS; walls *= 2)
+    benchmark_scene_updates(walls);
+  intervalTimer_reload(INTERVAL_TIMER_0);
+}
+#endif
+
+static void draw_frame(frame_t *frame) {
   drawing_t *current = NULL, *last = NULL;
 
   if (last_used_drawing1) {
@@ -76,35 +327,28 @@ static void draw_all(fixp_t x, fixp_t y, fixp_t a) {
     last_used_drawing1 = true;
   }
 
-  renderer_create_drawing(current, &frame);
+  renderer_create_drawing(current, frame);
   draw_to_screen(current, last);
 }
 
 #define MOVE_SPEED_PER_SECOND 1
 #define TURN_SPEED_PER_SECOND 1
 
-static void move(double delta_time, fixp_t *x, fixp_t *y, fixp_t *a) {
-  uint8_t buttons = buttons_read();
-
+static void move(input_t *input, map_point_t *camera, fixp_t *a) {
   double move_dist = 0;
-  if (buttons & BUTTONS_BTN3_MASK)
-    move_dist += delta_time * MOVE_SPEED_PER_SECOND;
-
-  if (buttons & BUTTONS_BTN2_MASK)
-    move_dist -= delta_time * MOVE_SPEED_PER_SECOND;
+  move_dist += INPUT_HELD_SECONDS(input, INPUT_BTN3) * MOVE_SPEED_PER_SECOND;
+  move_dist -= INPUT_HELD_SECONDS(input, INPUT_BTN2) * MOVE_SPEED_PER_SECOND;
 
   if (move_dist != 0) {
     fixp_t dist = REAL_TO_FIXP(move_dist);
-    *x += FIXP_MULT(dist, COS(*a));
-    *y += FIXP_MULT(dist, SIN(*a));
+    camera->x += FIXP_MULT(dist, COS(*a));
+    camera->y += FIXP_MULT(dist, SIN(*a));
+    renderer_normalize_point(camera);
   }
 
   double turn_dist = 0;
-  if (buttons & BUTTONS_BTN1_MASK)
-    turn_dist += delta_time * TURN_SPEED_PER_SECOND;
-
-  if (buttons & BUTTONS_BTN0_MASK)
-    turn_dist -= delta_time * TURN_SPEED_PER_SECOND;
+  turn_dist += INPUT_HELD_SECONDS(input, INPUT_BTN1) * TURN_SPEED_PER_SECOND;
+  turn_dist -= INPUT_HELD_SECONDS(input, INPUT_BTN0) * TURN_SPEED_PER_SECOND;
 
   if (turn_dist != 0)
     *a += REAL_TO_FIXP(turn_dist);
@@ -120,31 +364,201 @@ static void init() {
   display_init();
   display_fillScreen(DISPLAY_BLACK);
   buttons_init();
+  interrupts_init();
+  input_init();
   intervalTimer_initCountUp(INTERVAL_TIMER_0);
   intervalTimer_start(INTERVAL_TIMER_0);
+  trace_init();
+  build_level();
 }
 
 #define MIN_TIME_TICK 0.05
+
+// While waiting out the tick, render the poses the next `move` is most likely
+// to land on: the last input held for another tick, and turning either way
+// on top of it. If the camera ends up on one of them, its frame is drawn
+// without rendering.
+#define SPECULATIONS 3
+#define SPECULATE_DEFAULT_SAMPLES ((uint16_t)(MIN_TIME_TICK * INPUT_SAMPLE_HZ))
+#define SPECULATE_REPORT_EVERY 100 // frames
+
+typedef struct {
+  bool ready;
+  bool repeat; // A copy of the frame drawn last, not a render of its own
+  map_point_t camera;
+  fixp_t a;
+  frame_t frame;
+} speculation_t;
+
+static speculation_t speculations[SPECULATIONS];
+static double last_render_time = MIN_TIME_TICK;
+static uint32_t spec_frames = 0;
+static uint32_t spec_hits = 0;
+static uint32_t spec_repeats = 0;
+static uint32_t spec_rendered = 0;
+
+static bool same_pose(map_point_t *camera_a, fixp_t a_a, map_point_t *camera_b,
+                      fixp_t a_b) {
+  return a_a == a_b && camera_a->tile_x == camera_b->tile_x &&
+         camera_a->tile_y == camera_b->tile_y && camera_a->x == camera_b->x &&
+         camera_a->y == camera_b->y;
+}
+
+// A button held through the whole last tick tells how many samples the next
+// one is likely to be.
+static uint16_t tick_samples(input_t *input) {
+  uint16_t samples = 0;
+  for (uint8_t i = 0; i < INPUT_BUTTON_COUNT; i++) {
+    if (input->held[i] > samples)
+      samples = input->held[i];
+  }
+  return samples ? samples : SPECULATE_DEFAULT_SAMPLES;
+}
+
+static void speculate(input_t *last_input, frame_t *drawn, map_point_t *camera,
+                      fixp_t a) {
+  uint16_t samples = tick_samples(last_input);
+  input_t predicted[SPECULATIONS] = {*last_input, *last_input, *last_input};
+  predicted[1].held[INPUT_BTN1] = samples;
+  predicted[1].held[INPUT_BTN0] = 0;
+  predicted[2].held[INPUT_BTN0] = samples;
+  predicted[2].held[INPUT_BTN1] = 0;
+
+  // Frames left from the last tick are for poses that have already passed.
+  for (uint8_t i = 0; i < SPECULATIONS; i++)
+    speculations[i].ready = false;
+
+  for (uint8_t i = 0; i < SPECULATIONS; i++) {
+    speculation_t *spec = &speculations[i];
+    double elapsed = intervalTimer_getTotalDurationInSeconds(INTERVAL_TIMER_0);
+    if (elapsed + last_render_time > MIN_TIME_TICK)
+      return;
+
+    spec->camera = *camera;
+    spec->a = a;
+    move(&predicted[i], &spec->camera, &spec->a);
+
+    // Standing still predicts the pose that was just drawn. Only the first
+    // prediction can, since the others turn, so `drawn` has not been
+    // overwritten by then.
+    if (same_pose(&spec->camera, spec->a, camera, a)) {
+      if (&spec->frame != drawn)
+        spec->frame = *drawn;
+      spec->ready = true;
+      spec->repeat = true;
+      continue;
+    }
+
+    bool duplicate = false;
+    for (uint8_t j = 0; j < i; j++) {
+      if (speculations[j].ready &&
+          same_pose(&speculations[j].camera, speculations[j].a, &spec->camera,
+                    spec->a))
+        duplicate = true;
+    }
+    if (duplicate)
+      continue;
+
+    render_all(&spec->frame, &spec->camera, spec->a);
+    spec->ready = true;
+    spec->repeat = false;
+    spec_rendered++;
+  }
+}
+
+// Printed outside the timed part of a frame, since printing to the console is
+// slow.
+static void report_speculation() {
+  if (spec_frames < SPECULATE_REPORT_EVERY)
+    return;
+
+  printf("Speculation: %ld of %ld frames hit, %ld repeated the last frame, "
+         "%ld of %ld renders wasted\n",
+         (long)spec_hits, (long)spec_frames, (long)spec_repeats,
+         (long)(spec_rendered - spec_hits), (long)spec_rendered);
+
+  spec_frames = 0;
+  spec_hits = 0;
+  spec_repeats = 0;
+  spec_rendered = 0;
+}
+
+// Walls that changed since the speculations were rendered are missing from
+// them, so only the columns they cover are rendered again.
+static void patch_speculations() {
+  for (uint8_t i = 0; i < SPECULATIONS; i++) {
+    if (speculations[i].ready)
+      scene_patch_frame(&scene, &speculations[i].frame);
+  }
+  scene_clear_changes(&scene);
+}
+
+// Returns the speculated frame for the pose, or NULL if there is none.
+static frame_t *take_speculation(map_point_t *camera, fixp_t a) {
+  frame_t *frame = NULL;
+  for (uint8_t i = 0; i < SPECULATIONS; i++) {
+    speculation_t *spec = &speculations[i];
+    if (spec->ready && same_pose(&spec->camera, spec->a, camera, a)) {
+      frame = &spec->frame;
+      if (spec->repeat)
+        spec_repeats++;
+      else
+        spec_hits++;
+      break;
+    }
+  }
+
+  spec_frames++;
+  return frame;
+}
+
 int main() {
   init();
+#ifdef RENDERER_BENCHMARK
+  benchmark();
+#endif
+
+  map_point_t camera = MAP_POINT(0, 0);
+  fixp_t a = REAL_TO_FIXP(0);
 
-  fixp_t x = REAL_TO_FIXP(0), y = REAL_TO_FIXP(0), a = REAL_TO_FIXP(0);
+  while (!trace_done()) {
+    // Apply the input right before rendering so nothing that happened during
+    // the last frame waits for another one.
+    input_t input;
+    input_poll(&input);
+    trace_input(&input);
+    move(&input, &camera, &a);
+    patch_speculations();
 
-  while (true) {
     // printf("%f, %f, %f\n", FIXP_TO_REAL(x), FIXP_TO_REAL(y),
     // FIXP_TO_REAL(a));
-    draw_all(x, y, a);
+    frame_t rendered;
+    trace_frame_start();
+    frame_t *frame = take_speculation(&camera, a);
+    if (!frame) {
+      double start = intervalTimer_getTotalDurationInSeconds(INTERVAL_TIMER_0);
+      render_all(&rendered, &camera, a);
+      last_render_time =
+          intervalTimer_getTotalDurationInSeconds(INTERVAL_TIMER_0) - start;
+      frame = &rendered;
+    }
+    draw_frame(frame);
+    trace_frame_end(frame);
+    input_report_latency();
+    report_speculation();
     // while (1);
 
+    speculate(&input, frame, &camera, a);
+
     double time_change;
     do {
       time_change = intervalTimer_getTotalDurationInSeconds(INTERVAL_TIMER_0);
     } while (time_change < MIN_TIME_TICK);
     intervalTimer_reload(INTERVAL_TIMER_0);
-
-    move(time_change, &x, &y, &a);
   }
 
+  return trace_report() ? 0 : 1;
+
   // frame_t frame;
   // renderer_init_render(&frame, 0, 0, -1);
   // return 0;
@@ -11,27 +11,67 @@
 
 #define NOTHING_HEIGHT 0
 
-void renderer_init_frame(frame_t *frame, fixp_t x, fixp_t y, fixp_t a) {
-  frame->x = x;
-  frame->y = y;
+// Carries whole tiles out of a point's position within its tile, after it has
+// been moved by less than a tile.
+void renderer_normalize_point(map_point_t *point) {
+  point->tile_x += point->x >> MAP_TILE_SHIFT;
+  point->tile_y += point->y >> MAP_TILE_SHIFT;
+  point->x &= MAP_TILE_MASK;
+  point->y &= MAP_TILE_MASK;
+}
+
+void renderer_init_frame(frame_t *frame, map_point_t *camera, fixp_t a) {
+  frame->camera = *camera;
 
   // ASSERT(VALID_ANGLE(a));
 
   frame->sin_a = SIN(a);
   frame->cos_a = COS(a);
 
+  frame->clip_start = 0;
+  frame->clip_end = FRAME_WIDTH - 1;
+
   for (uint16_t i = 0; i < FRAME_WIDTH; i++) {
     frame->heights[i] = NOTHING_HEIGHT;
   }
 }
 
-static void transform_point(render_point_t *t_dest, render_point_t *src,
+// Clears the columns from `start` to `end`, and limits rendering to them until
+// `renderer_end_columns`, so they can be rendered again without touching the
+// rest of the frame.
+void renderer_begin_columns(frame_t *frame, int16_t start, int16_t end) {
+  frame->clip_start = start;
+  frame->clip_end = end;
+
+  for (int16_t i = start; i <= end; i++) {
+    frame->heights[i] = NOTHING_HEIGHT;
+  }
+}
+
+void renderer_end_columns(frame_t *frame) {
+  frame->clip_start = 0;
+  frame->clip_end = FRAME_WIDTH - 1;
+}
+
+// Returns false if the point is further than VIEW_RADIUS from the camera.
+static bool transform_point(render_point_t *t_dest, map_point_t *src,
                             frame_t *frame) {
-  fixp_t sx = (src->x - frame->x);
-  fixp_t sy = (src->y - frame->y);
+  int32_t dx =
+      ((int32_t)(src->tile_x - frame->camera.tile_x) << MAP_TILE_SHIFT) +
+      (src->x - frame->camera.x);
+  int32_t dy =
+      ((int32_t)(src->tile_y - frame->camera.tile_y) << MAP_TILE_SHIFT) +
+      (src->y - frame->camera.y);
+
+  if (abs(dx) > VIEW_RADIUS || abs(dy) > VIEW_RADIUS)
+    return false;
+
+  fixp_t sx = dx;
+  fixp_t sy = dy;
 
   t_dest->x = FIXP_MULT(sx, frame->cos_a) + FIXP_MULT(sy, frame->sin_a);
   t_dest->y = FIXP_MULT(-sx, frame->sin_a) + FIXP_MULT(sy, frame->cos_a);
+  return true;
 }
 
 static bool is_point_behind_camera(render_point_t *t_point) {
@@ -85,8 +125,8 @@ enum line_render_mode {
 
 // It's complicated how this works, related to the cross product.
 // https://www.desmos.com/calculator/hojnglocvc for a visualization
-static fixp_t origin_line_val(render_point_t *a, render_point_t *b) {
-  return (FIXP_MULT(b->x - a->x, -a->y) - FIXP_MULT(b->y - a->y, -a->x));
+static fixph_t origin_line_val(render_point_t *a, render_point_t *b) {
+  return (FIXPH_MULT(b->x - a->x, -a->y) - FIXPH_MULT(b->y - a->y, -a->x));
 }
 
 static enum line_render_mode compute_render_mode(render_point_t *tp1,
@@ -124,7 +164,7 @@ static enum line_render_mode compute_render_mode(render_point_t *tp1,
     if (first_above == second_above)
       return LRM_DO_NOT_RENDER;
 
-    fixp_t val = origin_line_val(tp1, tp2);
+    fixph_t val = origin_line_val(tp1, tp2);
 
     // Easy quick check to see if perfectly in line with camera. If so, do not
     // render.
@@ -139,7 +179,7 @@ static enum line_render_mode compute_render_mode(render_point_t *tp1,
     }
   }
 
-  fixp_t val = origin_line_val(tp1, tp2);
+  fixph_t val = origin_line_val(tp1, tp2);
 
   // Easy quick check to see if perfectly in line with camera. If so, do not
   // render.
@@ -166,18 +206,26 @@ fixp_t slope_inv) { if (a->y == b->y) return (a->y + b->y) / 2;
     return FIXP_MULT(y - a->y, FIXP_DIV(b->x - a->x, b->y - a->y)) + a->x;
 }*/
 
+// Trimming shears the points, which can double their coordinates, so it is
+// done in fixph_t. The point it finds is on the original line, so it fits back
+// in a render_point_t.
+typedef struct {
+  fixph_t x;
+  fixph_t y;
+} wide_point_t;
+
 // Computes the `y` value for a given `x`
-static fixp_t interpolate_y(render_point_t *a, render_point_t *b, fixp_t x) {
+static fixph_t interpolate_y(wide_point_t *a, wide_point_t *b, fixph_t x) {
   if (a->x == b->x)
     return (a->x + b->x) / 2;
 
-  return FIXP_MULT(x - a->x, FIXP_DIV(b->y - a->y, b->x - a->x)) + a->y;
+  return FIXPH_MULT(x - a->x, FIXPH_DIV(b->y - a->y, b->x - a->x)) + a->y;
 }
 
 static render_point_t trim_line_to_left(render_point_t *tp1,
                                         render_point_t *tp2) {
-  render_point_t to_trim_s = {.x = tp1->x - tp1->y, .y = tp1->y};
-  render_point_t other_s = {.x = tp2->x - tp2->y, .y = tp2->y};
+  wide_point_t to_trim_s = {.x = (fixph_t)tp1->x - tp1->y, .y = tp1->y};
+  wide_point_t other_s = {.x = (fixph_t)tp2->x - tp2->y, .y = tp2->y};
 
   fixp_t new_y = interpolate_y(&to_trim_s, &other_s, 0);
   return (render_point_t){.x = new_y, .y = new_y};
@@ -185,8 +233,8 @@ static render_point_t trim_line_to_left(render_point_t *tp1,
 
 static render_point_t trim_line_to_right(render_point_t *tp1,
                                          render_point_t *tp2) {
-  render_point_t to_trim_s = {.x = tp1->x + tp1->y, .y = tp1->y};
-  render_point_t other_s = {.x = tp2->x + tp2->y, .y = tp2->y};
+  wide_point_t to_trim_s = {.x = (fixph_t)tp1->x + tp1->y, .y = tp1->y};
+  wide_point_t other_s = {.x = (fixph_t)tp2->x + tp2->y, .y = tp2->y};
 
   fixp_t new_y = interpolate_y(&to_trim_s, &other_s, 0);
   return (render_point_t){.x = -new_y, .y = new_y};
@@ -206,11 +254,14 @@ static void trim_point(render_point_t *cp, uint8_t mode,
   }
 }
 
-static fixp_t compute_slope_inv(render_point_t *a, render_point_t *b) {
-  return FIXP_DIV(b->x - a->x, b->y - a->y);
+// Heights of walls right in front of the camera can pass the range of fixp_t in
+// 16-bit mode, so they stay in fixph_t until they are capped to HEIGHT_CAP.
+static fixph_t compute_slope_inv(fixph_t h1, fixp_t y1, fixph_t h2,
+                                 fixp_t y2) {
+  return FIXPH_DIV(h2 - h1, y2 - y1);
 }
 
-static fixp_t height_from_depth(fixp_t depth) {
+static fixph_t height_from_depth(fixp_t depth) {
   // printf("Depth: %f\n", FIXP_TO_REAL(depth));
 
   // printf("Capped: %f\n", FIXP_TO_REAL(depth));
@@ -218,18 +269,25 @@ static fixp_t height_from_depth(fixp_t depth) {
   // printf("Capped: %f\n", FIXP_TO_REAL(FIXP_DIV(INT_TO_FIXP(FRAME_HEIGHT),
   // depth)));
 
-  return FIXP_DIV(INT_TO_FIXP(FRAME_HEIGHT), depth);
+  return FIXPH_DIV(INT_TO_FIXP(FRAME_HEIGHT), depth);
 }
 
 #define HEIGHT_CAP INT_TO_FIXP(FRAME_HEIGHT)
-static void render_line(frame_t *frame, render_point_t *tp1,
-                        render_point_t *tp2) {
+
+typedef struct {
+  int16_t start, end;
+  fixph_t height; // Height at `start`
+  fixph_t slope;  // Change in height per column
+} line_span_t;
+
+static bool project_line(line_span_t *span, render_point_t *tp1,
+                         render_point_t *tp2) {
   printf("tp1: (%f, %f)\n", FIXP_TO_REAL(tp1->x), FIXP_TO_REAL(tp1->y));
   printf("tp2: (%f, %f)\n", FIXP_TO_REAL(tp2->x), FIXP_TO_REAL(tp2->y));
 
   enum line_render_mode lrm = compute_render_mode(tp1, tp2);
   if (!SHOULD_RENDER(lrm))
-    return;
+    return false;
 
   printf("Continuing with render mode %x...\n", lrm);
 
@@ -240,6 +298,12 @@ static void render_line(frame_t *frame, render_point_t *tp1,
   printf("cp1: (%f, %f)\n", FIXP_TO_REAL(cp1.x), FIXP_TO_REAL(cp1.y));
   printf("cp2: (%f, %f)\n", FIXP_TO_REAL(cp2.x), FIXP_TO_REAL(cp2.y));
 
+  // A trimmed point can land on the camera itself, where there is no sensible
+  // height to draw. In 16-bit mode the rebased points are coarse enough that
+  // this happens from ordinary poses, and dividing by its depth would trap.
+  if (cp1.x <= 0 || cp2.x <= 0)
+    return false;
+
   // Adjust left/right based on distance.
   // Change distance to height
   cp1.y = FIXP_DIV((FRAME_WIDTH / 2) * cp1.y, cp1.x);
@@ -249,28 +313,28 @@ static void render_line(frame_t *frame, render_point_t *tp1,
   printf("cp1: (%f, %f)\n", FIXP_TO_REAL(cp1.x), FIXP_TO_REAL(cp1.y));
   printf("cp2: (%f, %f)\n", FIXP_TO_REAL(cp2.x), FIXP_TO_REAL(cp2.y));
 
-  cp1.x = height_from_depth(cp1.x);
-  cp2.x = height_from_depth(cp2.x);
+  fixph_t h1 = height_from_depth(cp1.x);
+  fixph_t h2 = height_from_depth(cp2.x);
 
-  printf("X is now height:\n");
-  printf("cp1: (%f, %f)\n", FIXP_TO_REAL(cp1.x), FIXP_TO_REAL(cp1.y));
-  printf("cp2: (%f, %f)\n", FIXP_TO_REAL(cp2.x), FIXP_TO_REAL(cp2.y));
+  printf("Heights:\n");
+  printf("h1: %f\n", FIXP_TO_REAL(h1));
+  printf("h2: %f\n", FIXP_TO_REAL(h2));
 
   if (cp1.y == cp2.y)
-    return;
+    return false;
 
   int16_t start, end;
-  fixp_t slope = -compute_slope_inv(&cp1, &cp2);
-  fixp_t height;
+  fixph_t slope = -compute_slope_inv(h1, cp1.y, h2, cp2.y);
+  fixph_t height;
 
   if (cp1.y <= cp2.y) {
     start = FIXP_TO_INT(-cp2.y) + (FRAME_WIDTH / 2);
     end = FIXP_TO_INT(-cp1.y) + (FRAME_WIDTH / 2);
-    height = cp2.x;
+    height = h2;
   } else {
     start = FIXP_TO_INT(-cp1.y) + (FRAME_WIDTH / 2);
     end = FIXP_TO_INT(-cp2.y) + (FRAME_WIDTH / 2);
-    height = cp1.x;
+    height = h1;
   }
 
   if (start < 0)
@@ -283,7 +347,61 @@ static void render_line(frame_t *frame, render_point_t *tp1,
   printf("Slope: %f\n", FIXP_TO_REAL(slope));
   printf("Init. Depth: %f\n", FIXP_TO_REAL(height));
 
-  for (uint16_t i = start; i <= end; i++) {
+  span->start = start;
+  span->end = end;
+  span->height = height;
+  span->slope = slope;
+  return start <= end;
+}
+
+// Columns past the ones a line's ends project to that it can still cover, since
+// project_line rounds them.
+#define CLIP_SLACK 2
+
+// Whether a line lies entirely to one side of the columns being rendered, so
+// it can be skipped before it is projected. A point's column is
+// FRAME_WIDTH / 2 - (FRAME_WIDTH / 2) * y / x, so comparing it to a column only
+// takes multiplying. Points level with or behind the camera could land in any
+// column, so they never rule a line out.
+static bool outside_clip(frame_t *frame, render_point_t *tp1,
+                         render_point_t *tp2) {
+  if (frame->clip_start == 0 && frame->clip_end == FRAME_WIDTH - 1)
+    return false;
+  if (tp1->x <= 0 || tp2->x <= 0)
+    return false;
+
+  fixpd_t y1 = (fixpd_t)(FRAME_WIDTH / 2) * tp1->y;
+  fixpd_t y2 = (fixpd_t)(FRAME_WIDTH / 2) * tp2->y;
+
+  fixpd_t left = (FRAME_WIDTH / 2) - frame->clip_start + CLIP_SLACK;
+  if (y1 > left * tp1->x && y2 > left * tp2->x)
+    return true;
+
+  fixpd_t right = (FRAME_WIDTH / 2) - frame->clip_end - CLIP_SLACK;
+  return y1 < right * tp1->x && y2 < right * tp2->x;
+}
+
+static void render_line(frame_t *frame, render_point_t *tp1,
+                        render_point_t *tp2) {
+  if (outside_clip(frame, tp1, tp2))
+    return;
+
+  line_span_t span;
+  if (!project_line(&span, tp1, tp2))
+    return;
+
+  int16_t start = span.start, end = span.end;
+  fixph_t height = span.height, slope = span.slope;
+
+  if (start < frame->clip_start) {
+    height += slope * (frame->clip_start - start);
+    start = frame->clip_start;
+  }
+
+  if (end > frame->clip_end)
+    end = frame->clip_end;
+
+  for (int16_t i = start; i <= end; i++) {
     fixp_t *frame_height = &(frame->heights[i]);
     if ((*frame_height == NOTHING_HEIGHT) || (height > *frame_height))
       *frame_height = (height > HEIGHT_CAP) ? HEIGHT_CAP : height;
@@ -291,22 +409,41 @@ static void render_line(frame_t *frame, render_point_t *tp1,
   }
 }
 
-void renderer_render_polygon(frame_t *frame, render_point_t points[],
-                             uint16_t n) {
+void renderer_render_polygon(frame_t *frame, map_point_t points[], uint16_t n) {
   render_point_t last_tpoint, next_tpoint;
-  transform_point(&last_tpoint, &points[0], frame);
+  bool last_near = transform_point(&last_tpoint, &points[0], frame);
 
   for (uint16_t i = 1; i < n; i++) {
     printf(" p1: (%f, %f)\n", FIXP_TO_REAL(points[i - 1].x),
            FIXP_TO_REAL(points[i - 1].y));
     printf(" p2: (%f, %f)\n", FIXP_TO_REAL(points[i].x),
            FIXP_TO_REAL(points[i].y));
-    transform_point(&next_tpoint, &points[i], frame);
-    render_line(frame, &last_tpoint, &next_tpoint);
+    bool next_near = transform_point(&next_tpoint, &points[i], frame);
+    if (last_near && next_near)
+      render_line(frame, &last_tpoint, &next_tpoint);
     last_tpoint = next_tpoint;
+    last_near = next_near;
   }
 }
 
+// Finds the columns the wall from `points[0]` to `points[1]` covers in the
+// frame. Returns false if it is not on screen.
+bool renderer_wall_columns(frame_t *frame, map_point_t points[], int16_t *start,
+                           int16_t *end) {
+  render_point_t tp1, tp2;
+  if (!transform_point(&tp1, &points[0], frame) ||
+      !transform_point(&tp2, &points[1], frame))
+    return false;
+
+  line_span_t span;
+  if (!project_line(&span, &tp1, &tp2))
+    return false;
+
+  *start = span.start;
+  *end = span.end;
+  return true;
+}
+
 #define BG_COLOR DISPLAY_BLACK
 #define GRAD_1_COLOR DISPLAY_WHITE
 #define GRAD_1_CAP (REAL_TO_FIXP(1.0 * FRAME_HEIGHT * 2 / 3))
@@ -359,6 +496,22 @@ void renderer_clear_drawing(drawing_t *drawing) {
   }
 }
 
+// FNV-1a over the heights, least significant byte first so the hash does not
+// depend on the byte order of the machine computing it.
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+uint32_t renderer_hash_frame(frame_t *frame) {
+  uint32_t hash = FNV_OFFSET_BASIS;
+  for (uint16_t x = 0; x < FRAME_WIDTH; x++) {
+    ufixp_t height = frame->heights[x];
+    for (uint8_t byte = 0; byte < sizeof(height); byte++) {
+      hash ^= (height >> (8 * byte)) & 0xff;
+      hash *= FNV_PRIME;
+    }
+  }
+  return hash;
+}
+
 /*
 void debug_routine() {
 
@@ -7,13 +7,54 @@
 #define FRAME_WIDTH DISPLAY_WIDTH
 #define FRAME_HEIGHT DISPLAY_HEIGHT
 
+// Uncomment this line to render the level from a tile grid, casting one ray
+// per column, instead of drawing every wall segment. Its cost depends on how
+// many cells the rays cross rather than how many walls there are, but only
+// walls along whole grid lines can be drawn.
+// #define RENDERER_GRID
+
 typedef struct {
   fixp_t x;
   fixp_t y;
 } render_point_t;
 
+// A point on the map, stored as the tile it is in and its position within
+// that tile. Only the difference from the camera's tile is ever widened, so a
+// map can be far larger than the range of fixp_t. Walls must be no longer than
+// a tile, so a wall that is close enough to see never has an endpoint that is
+// too far away to rebase.
+#define MAP_TILE_BITS 4 // 16 units
+#define MAP_TILE_SHIFT (MAP_TILE_BITS + FIXP_RIGHT_BITS)
+#define MAP_TILE_MASK ((1 << MAP_TILE_SHIFT) - 1)
+
+typedef struct {
+  int16_t tile_x, tile_y;
+  fixp_t x, y;
+} map_point_t;
+
+#define MAP_COORD_TILE(real) ((int16_t)(REAL_TO_FIXPD(real) >> MAP_TILE_SHIFT))
+#define MAP_COORD_LOCAL(real) ((fixp_t)(REAL_TO_FIXPD(real) & MAP_TILE_MASK))
+#define MAP_POINT(X, Y)                                                        \
+  {                                                                            \
+    .tile_x = MAP_COORD_TILE(X), .tile_y = MAP_COORD_TILE(Y),                  \
+    .x = MAP_COORD_LOCAL(X), .y = MAP_COORD_LOCAL(Y)                           \
+  }
+
+// Points further than this from the camera along either axis are not drawn.
+// Walls past FRAME_HEIGHT units away are under a pixel tall anyway, and the
+// bound keeps the camera-relative math in renderer.c inside its types: rotated
+// points stay within sqrt(2) * VIEW_RADIUS in fixp_t, and the products in
+// `origin_line_val` within 4 * VIEW_RADIUS^2 in fixph_t.
+#ifdef FIXP_16_MODE
+#define VIEW_RADIUS INT_TO_FIXP(256)
+#else
+#define VIEW_RADIUS INT_TO_FIXP(2048)
+#endif
+
 typedef struct {
-  fixp_t x, y, sin_a, cos_a;
+  map_point_t camera;
+  fixp_t sin_a, cos_a;
+  int16_t clip_start, clip_end; // Columns rendering is limited to
   fixp_t heights[FRAME_WIDTH];
 } frame_t;
 
@@ -21,10 +62,40 @@ typedef struct {
   uint16_t pixels[FRAME_WIDTH][FRAME_HEIGHT];
 } drawing_t;
 
-void renderer_init_frame(frame_t *frame, fixp_t x, fixp_t y, fixp_t a);
-void renderer_render_polygon(frame_t *frame, render_point_t points[],
-                             uint16_t n);
+// Walls of a tile grid are stored on the edges of its cells, so the thin walls
+// of the segment maps fit it exactly. Each cell holds its lowest x and y edges,
+// so the cells are stored with an extra column and row past the grid to hold
+// its far edges. Walls outside the grid are left out.
+#define GRID_WALL_X 0x1 // Wall along the cell's edge at its lowest x
+#define GRID_WALL_Y 0x2 // Wall along the cell's edge at its lowest y
+
+#define GRID_CELLS(width, height) (((width) + 1) * ((height) + 1))
+
+typedef struct {
+  int16_t origin_x, origin_y; // Map position of cell (0, 0), in whole units
+  uint8_t width, height;
+  uint8_t *cells; // GRID_CELLS(width, height), one row of x after another
+} grid_map_t;
+
+void renderer_normalize_point(map_point_t *point);
+void renderer_init_frame(frame_t *frame, map_point_t *camera, fixp_t a);
+void renderer_begin_columns(frame_t *frame, int16_t start, int16_t end);
+void renderer_end_columns(frame_t *frame);
+void renderer_render_polygon(frame_t *frame, map_point_t points[], uint16_t n);
+bool renderer_wall_columns(frame_t *frame, map_point_t points[], int16_t *start,
+                           int16_t *end);
 void renderer_create_drawing(drawing_t *dest, frame_t *src);
 void renderer_clear_drawing(drawing_t *drawing);
+uint32_t renderer_hash_frame(frame_t *frame);
+
+void renderer_grid_clear(grid_map_t *grid);
+void renderer_grid_add_polygon(grid_map_t *grid, map_point_t points[],
+                               uint16_t n);
+void renderer_grid_remove_polygon(grid_map_t *grid, map_point_t points[],
+                                  uint16_t n);
+void renderer_render_grid(frame_t *frame, grid_map_t *grid);
+bool renderer_grid_wall_columns(frame_t *frame, grid_map_t *grid,
+                                map_point_t points[], int16_t *start,
+                                int16_t *end);
 
 #endif
\ No newline at end of file
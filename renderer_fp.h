@@ -5,7 +5,8 @@
 
 // Uncomment this line to change it from (25.7) to (10.6) fixed point.
 // The main reason I bumped it up was due to some graphical glitches using the
-// very small space. If you don't mind the glitches, 16-bit works just fine.
+// very small space. Map points are now stored relative to their tile and the
+// math that can outgrow 10.6 is done in fixph_t, so 16-bit works on any map.
 //#define FIXP_16_MODE
 
 #ifdef FIXP_16_MODE
@@ -14,6 +15,9 @@ typedef int32_t fixpd_t;
 typedef uint16_t ufixp_t;
 typedef uint32_t ufixpd_t;
 
+typedef int32_t fixph_t;
+typedef int32_t fixphd_t;
+
 #define FIXP_RIGHT_BITS 6
 #define FIXP_LEFT_BITS 10
 #else
@@ -22,6 +26,9 @@ typedef int64_t fixpd_t;
 typedef uint32_t ufixp_t;
 typedef uint64_t ufixpd_t;
 
+typedef fixp_t fixph_t;
+typedef fixpd_t fixphd_t;
+
 #define FIXP_RIGHT_BITS 7
 #define FIXP_LEFT_BITS 25
 #endif
@@ -35,6 +42,17 @@ typedef uint64_t ufixpd_t;
 #define FIXP_DIV(a, b)                                                         \
   ((fixp_t)((((fixpd_t)a) << FIXP_RIGHT_BITS) / ((fixpd_t)b)))
 
+// fixph_t holds values that can pass the range of fixp_t in 16-bit mode, such
+// as wall heights before they are capped. It is just fixp_t in 32-bit mode.
+// Dividing shifts the dividend by FIXP_RIGHT_BITS, which still fits in 32 bits
+// in 16-bit mode, so only products of two fixph_t go through int64_t; the
+// board has no divider, and 64-bit division is a library call.
+#define REAL_TO_FIXPD(real) ((fixpd_t)(real * (1 << FIXP_RIGHT_BITS) + 0.5))
+#define FIXPH_MULT(a, b)                                                       \
+  ((fixph_t)((((int64_t)(a)) * ((int64_t)(b))) >> FIXP_RIGHT_BITS))
+#define FIXPH_DIV(a, b)                                                        \
+  ((fixph_t)((((fixphd_t)(a)) << FIXP_RIGHT_BITS) / ((fixphd_t)(b))))
+
 #define INT_TO_UFIXP(int) ((ufixp_t)(int << FIXP_RIGHT_BITS))
 #define FIXP_TO_INT(fixp) (fixp >> FIXP_RIGHT_BITS)
 #define REAL_TO_UFIXP(real) ((ufixp_t)(real * (1 << FIXP_RIGHT_BITS) + 0.5))
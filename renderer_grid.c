@@ -0,0 +1,298 @@
+#include "renderer.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define HEIGHT_CAP INT_TO_FIXP(FRAME_HEIGHT)
+
+// Rays are traced with more fraction bits than fixp_t has, since neighbouring
+// columns differ by less than 1/128 in direction.
+#define RAY_BITS 16
+#define RAY_ONE ((int64_t)1 << RAY_BITS)
+
+// Walls past this distance are under a pixel tall, so rays stop here.
+#define RAY_MAX_DEPTH ((int64_t)FRAME_HEIGHT << RAY_BITS)
+#define RAY_NO_HIT -1
+
+// Cameras further than this from the grid can not see any of it.
+#define GRID_MAX_DISTANCE (FRAME_HEIGHT + UINT8_MAX)
+
+// Points further than this from a grid line are not on the grid.
+#define ON_GRID_TOLERANCE (1 << (FIXP_RIGHT_BITS - 3))
+
+static int32_t map_coord(int16_t tile, fixp_t local) {
+  return ((int32_t)tile << MAP_TILE_SHIFT) + local;
+}
+
+// Rounds a map coordinate to the grid line it is on. Returns false if it is
+// not on one.
+static bool grid_line(int32_t coord, int16_t origin, int16_t *line) {
+  int32_t rounded = (coord + (1 << (FIXP_RIGHT_BITS - 1))) >> FIXP_RIGHT_BITS;
+  if (abs(coord - (rounded << FIXP_RIGHT_BITS)) > ON_GRID_TOLERANCE)
+    return false;
+
+  *line = rounded - origin;
+  return true;
+}
+
+// Index of the cell holding the edges at (x, y), or -1 if it is past the far
+// edges of the grid.
+static int32_t edge_cell(grid_map_t *grid, int32_t x, int32_t y) {
+  if (x < 0 || y < 0 || x > grid->width || y > grid->height)
+    return -1;
+
+  return y * (grid->width + 1) + x;
+}
+
+static void set_wall(grid_map_t *grid, int16_t x, int16_t y, uint8_t wall,
+                     bool add) {
+  // Past the far edges only the edges along them are part of the grid.
+  if ((x == grid->width && wall != GRID_WALL_X) ||
+      (y == grid->height && wall != GRID_WALL_Y))
+    return;
+
+  int32_t cell = edge_cell(grid, x, y);
+  if (cell < 0)
+    return;
+
+  if (add)
+    grid->cells[cell] |= wall;
+  else
+    grid->cells[cell] &= ~wall;
+}
+
+void renderer_grid_clear(grid_map_t *grid) {
+  for (uint16_t i = 0; i < GRID_CELLS(grid->width, grid->height); i++)
+    grid->cells[i] = 0;
+}
+
+// Finds the grid lines the wall from `p1` to `p2` runs along, as the cell
+// corners at its ends. Returns false if it is not along one.
+static bool grid_wall(grid_map_t *grid, map_point_t *p1, map_point_t *p2,
+                      int16_t *x1, int16_t *y1, int16_t *x2, int16_t *y2) {
+  if (!grid_line(map_coord(p1->tile_x, p1->x), grid->origin_x, x1) ||
+      !grid_line(map_coord(p1->tile_y, p1->y), grid->origin_y, y1) ||
+      !grid_line(map_coord(p2->tile_x, p2->x), grid->origin_x, x2) ||
+      !grid_line(map_coord(p2->tile_y, p2->y), grid->origin_y, y2))
+    return false;
+
+  return *x1 == *x2 || *y1 == *y2;
+}
+
+static void update_polygon(grid_map_t *grid, map_point_t points[], uint16_t n,
+                           bool add) {
+  for (uint16_t i = 1; i < n; i++) {
+    int16_t x1, y1, x2, y2;
+    if (!grid_wall(grid, &points[i - 1], &points[i], &x1, &y1, &x2, &y2))
+      continue;
+
+    if (x1 == x2) {
+      for (int16_t y = (y1 < y2 ? y1 : y2); y < (y1 < y2 ? y2 : y1); y++)
+        set_wall(grid, x1, y, GRID_WALL_X, add);
+    } else if (y1 == y2) {
+      for (int16_t x = (x1 < x2 ? x1 : x2); x < (x1 < x2 ? x2 : x1); x++)
+        set_wall(grid, x, y1, GRID_WALL_Y, add);
+    }
+  }
+}
+
+// Adds every wall of the polygon that lies along a grid line. Walls that do
+// not are left out.
+void renderer_grid_add_polygon(grid_map_t *grid, map_point_t points[],
+                               uint16_t n) {
+  update_polygon(grid, points, n, true);
+}
+
+// Removes the walls of the polygon from the grid, only touching the edges they
+// cover. An edge shared with another wall is removed along with it, so callers
+// that can have overlapping walls need to add the others back.
+void renderer_grid_remove_polygon(grid_map_t *grid, map_point_t points[],
+                                  uint16_t n) {
+  update_polygon(grid, points, n, false);
+}
+
+static bool has_wall(grid_map_t *grid, int32_t x, int32_t y, uint8_t wall) {
+  int32_t cell = edge_cell(grid, x, y);
+  if (cell < 0)
+    return false;
+
+  return grid->cells[cell] & wall;
+}
+
+// Distance along the ray between crossings of one axis, and to the first one.
+static void ray_axis(int32_t dir, int32_t pos, int64_t *delta, int64_t *side,
+                     int8_t *step) {
+  if (dir == 0) {
+    *delta = RAY_MAX_DEPTH + 1;
+    *side = RAY_MAX_DEPTH + 1;
+    *step = 0;
+    return;
+  }
+
+  *delta = (RAY_ONE << RAY_BITS) / abs(dir);
+  int64_t frac = pos & (RAY_ONE - 1);
+  if (dir > 0) {
+    *step = 1;
+    *side = ((RAY_ONE - frac) * *delta) >> RAY_BITS;
+  } else {
+    *step = -1;
+    *side = (frac * *delta) >> RAY_BITS;
+  }
+}
+
+// True once the ray is past one side of the grid and not heading back in, so
+// it can not hit anything more.
+static bool left_grid(int32_t cell, int8_t step, uint8_t size) {
+  return (cell < 0 && step <= 0) || (cell >= size && step >= 0);
+}
+
+// Returns how far along the camera's view the first wall the ray hits is, or
+// RAY_NO_HIT if it hits none before RAY_MAX_DEPTH. `dir` has a length of one
+// along the view, so this is the same depth the segment renderer divides by.
+static int64_t cast_ray(grid_map_t *grid, int32_t pos_x, int32_t pos_y,
+                        int32_t dir_x, int32_t dir_y) {
+  int32_t cell_x = pos_x >> RAY_BITS, cell_y = pos_y >> RAY_BITS;
+  int64_t delta_x, delta_y, side_x, side_y;
+  int8_t step_x, step_y;
+  ray_axis(dir_x, pos_x, &delta_x, &side_x, &step_x);
+  ray_axis(dir_y, pos_y, &delta_y, &side_y, &step_y);
+
+  while (true) {
+    if (left_grid(cell_x, step_x, grid->width) ||
+        left_grid(cell_y, step_y, grid->height))
+      return RAY_NO_HIT;
+
+    if (side_x < side_y) {
+      if (side_x > RAY_MAX_DEPTH)
+        return RAY_NO_HIT;
+
+      // The wall between two cells is stored on the one with the higher x.
+      int32_t edge_x = (step_x > 0) ? cell_x + 1 : cell_x;
+      if (has_wall(grid, edge_x, cell_y, GRID_WALL_X))
+        return side_x;
+
+      cell_x += step_x;
+      side_x += delta_x;
+    } else {
+      if (side_y > RAY_MAX_DEPTH)
+        return RAY_NO_HIT;
+
+      int32_t edge_y = (step_y > 0) ? cell_y + 1 : cell_y;
+      if (has_wall(grid, cell_x, edge_y, GRID_WALL_Y))
+        return side_y;
+
+      cell_y += step_y;
+      side_y += delta_y;
+    }
+  }
+}
+
+// Finds the camera's position in the grid, with RAY_BITS fraction bits.
+// Returns false if it is too far away to see any of it.
+static bool grid_camera(frame_t *frame, grid_map_t *grid, int32_t *pos_x,
+                        int32_t *pos_y) {
+  int32_t cam_x = map_coord(frame->camera.tile_x, frame->camera.x) -
+                  ((int32_t)grid->origin_x << FIXP_RIGHT_BITS);
+  int32_t cam_y = map_coord(frame->camera.tile_y, frame->camera.y) -
+                  ((int32_t)grid->origin_y << FIXP_RIGHT_BITS);
+
+  if (abs(cam_x) > INT_TO_FIXP(GRID_MAX_DISTANCE) ||
+      abs(cam_y) > INT_TO_FIXP(GRID_MAX_DISTANCE))
+    return false;
+
+  *pos_x = cam_x << (RAY_BITS - FIXP_RIGHT_BITS);
+  *pos_y = cam_y << (RAY_BITS - FIXP_RIGHT_BITS);
+  return true;
+}
+
+void renderer_render_grid(frame_t *frame, grid_map_t *grid) {
+  int32_t pos_x, pos_y;
+  if (!grid_camera(frame, grid, &pos_x, &pos_y))
+    return;
+
+  int32_t cos_a = (int32_t)frame->cos_a << (RAY_BITS - FIXP_RIGHT_BITS);
+  int32_t sin_a = (int32_t)frame->sin_a << (RAY_BITS - FIXP_RIGHT_BITS);
+
+  for (int16_t x = frame->clip_start; x <= frame->clip_end; x++) {
+    // Column `x` looks along (1, t) in camera space, the inverse of the
+    // projection in render_line.
+    int32_t t =
+        ((int32_t)((FRAME_WIDTH / 2) - x) << RAY_BITS) / (FRAME_WIDTH / 2);
+    int32_t dir_x = cos_a - (((int64_t)sin_a * t) >> RAY_BITS);
+    int32_t dir_y = sin_a + (((int64_t)cos_a * t) >> RAY_BITS);
+
+    int64_t depth = cast_ray(grid, pos_x, pos_y, dir_x, dir_y);
+    if (depth == RAY_NO_HIT)
+      continue;
+
+    int64_t height = HEIGHT_CAP;
+    if (depth > 0)
+      height = ((int64_t)FRAME_HEIGHT << (RAY_BITS + FIXP_RIGHT_BITS)) / depth;
+    frame->heights[x] = (height > HEIGHT_CAP) ? HEIGHT_CAP : height;
+  }
+}
+
+// Columns past the ones a wall's ends project to that rays can still hit it
+// in, since both are rounded.
+#define COLUMN_SLACK 2
+
+// Finds the columns whose rays can hit the wall from `points[0]` to
+// `points[1]`, if it is on the grid. Rays are what decide it, so this follows
+// the wall's cell corners rather than projecting the segment. Returns false if
+// no ray can hit it.
+bool renderer_grid_wall_columns(frame_t *frame, grid_map_t *grid,
+                                map_point_t points[], int16_t *start,
+                                int16_t *end) {
+  int16_t corners[2][2];
+  int32_t pos_x, pos_y;
+  if (!grid_wall(grid, &points[0], &points[1], &corners[0][0], &corners[0][1],
+                 &corners[1][0], &corners[1][1]) ||
+      !grid_camera(frame, grid, &pos_x, &pos_y))
+    return false;
+
+  int64_t cos_a = (int64_t)frame->cos_a << (RAY_BITS - FIXP_RIGHT_BITS);
+  int64_t sin_a = (int64_t)frame->sin_a << (RAY_BITS - FIXP_RIGHT_BITS);
+
+  int64_t columns[2];
+  uint8_t behind = 0, level = 0;
+  for (uint8_t i = 0; i < 2; i++) {
+    int64_t rel_x = ((int64_t)corners[i][0] << RAY_BITS) - pos_x;
+    int64_t rel_y = ((int64_t)corners[i][1] << RAY_BITS) - pos_y;
+    int64_t depth = (rel_x * cos_a + rel_y * sin_a) >> RAY_BITS;
+    int64_t side = (rel_y * cos_a - rel_x * sin_a) >> RAY_BITS;
+
+    if (depth < 0) {
+      behind++;
+      continue;
+    }
+    if (depth == 0) {
+      level++;
+      continue;
+    }
+    // Column `x` looks along (1, t) with t = (FRAME_WIDTH / 2 - x) /
+    // (FRAME_WIDTH / 2), as in renderer_render_grid.
+    columns[i] = (FRAME_WIDTH / 2) - side * (FRAME_WIDTH / 2) / depth;
+  }
+
+  // Every ray heads away from the camera, so a wall entirely behind it can not
+  // be hit. One that reaches level with or behind it, such as a wall the
+  // camera stands on, can be hit anywhere out to an edge of the screen.
+  if (behind == 2)
+    return false;
+  if (behind + level > 0) {
+    *start = 0;
+    *end = FRAME_WIDTH - 1;
+    return true;
+  }
+
+  int64_t first = (columns[0] < columns[1]) ? columns[0] : columns[1];
+  int64_t last = (columns[0] < columns[1]) ? columns[1] : columns[0];
+  first -= COLUMN_SLACK;
+  last += COLUMN_SLACK;
+  if (last < 0 || first > FRAME_WIDTH - 1)
+    return false;
+
+  *start = (first < 0) ? 0 : first;
+  *end = (last > FRAME_WIDTH - 1) ? FRAME_WIDTH - 1 : last;
+  return true;
+}
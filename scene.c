@@ -0,0 +1,234 @@
+#include "scene.h"
+
+#include <stddef.h>
+
+// Walls entirely more than this many tiles from the camera's tile are too far
+// away to draw.
+#define VIEW_TILES ((VIEW_RADIUS >> MAP_TILE_SHIFT) + 1)
+
+void scene_init(scene_t *scene, grid_map_t *grid) {
+  scene->static_count = 0;
+  scene->count = 0;
+  scene->free_count = SCENE_MAX_WALLS;
+  for (uint16_t i = 0; i < SCENE_MAX_WALLS; i++) {
+    scene->slots[i] = SCENE_NO_WALL;
+    scene->free_handles[i] = SCENE_MAX_WALLS - 1 - i;
+  }
+
+  scene->change_count = 0;
+  scene->changes_overflowed = false;
+  scene->grid = grid;
+}
+
+static void record_change(scene_t *scene, map_point_t points[]) {
+  if (scene->change_count >= SCENE_MAX_CHANGES) {
+    scene->changes_overflowed = true;
+    return;
+  }
+
+  scene->changes[scene->change_count][0] = points[0];
+  scene->changes[scene->change_count][1] = points[1];
+  scene->change_count++;
+}
+
+static scene_bounds_t find_bounds(map_point_t points[], uint16_t n) {
+  scene_bounds_t bounds = {points[0].tile_x, points[0].tile_y,
+                           points[0].tile_x, points[0].tile_y};
+  for (uint16_t i = 1; i < n; i++) {
+    if (points[i].tile_x < bounds.min_tile_x)
+      bounds.min_tile_x = points[i].tile_x;
+    if (points[i].tile_x > bounds.max_tile_x)
+      bounds.max_tile_x = points[i].tile_x;
+    if (points[i].tile_y < bounds.min_tile_y)
+      bounds.min_tile_y = points[i].tile_y;
+    if (points[i].tile_y > bounds.max_tile_y)
+      bounds.max_tile_y = points[i].tile_y;
+  }
+  return bounds;
+}
+
+static void place_wall(scene_t *scene, scene_wall_t *wall, map_point_t *p1,
+                       map_point_t *p2) {
+  wall->points[0] = *p1;
+  wall->points[1] = *p2;
+  wall->bounds = find_bounds(wall->points, 2);
+
+  if (scene->grid)
+    renderer_grid_add_polygon(scene->grid, wall->points, 2);
+  record_change(scene, wall->points);
+}
+
+// A tile of slack, since grid lines sit on tile edges and points within a
+// fraction of a unit of one still count as on it.
+static bool bounds_near(scene_bounds_t *a, scene_bounds_t *b) {
+  return a->max_tile_x + 1 >= b->min_tile_x &&
+         b->max_tile_x + 1 >= a->min_tile_x &&
+         a->max_tile_y + 1 >= b->min_tile_y &&
+         b->max_tile_y + 1 >= a->min_tile_y;
+}
+
+// The grid only knows whether an edge has a wall, not how many, so removing a
+// wall also clears edges other walls share. Those walls are added back.
+static void unplace_wall(scene_t *scene, scene_wall_t *wall) {
+  if (scene->grid) {
+    renderer_grid_remove_polygon(scene->grid, wall->points, 2);
+    for (uint8_t i = 0; i < scene->static_count; i++) {
+      scene_static_t *other = &scene->statics[i];
+      if (bounds_near(&other->bounds, &wall->bounds))
+        renderer_grid_add_polygon(scene->grid, other->points, other->n);
+    }
+    for (uint16_t i = 0; i < scene->count; i++) {
+      scene_wall_t *other = &scene->walls[i];
+      if (other != wall && bounds_near(&other->bounds, &wall->bounds))
+        renderer_grid_add_polygon(scene->grid, other->points, 2);
+    }
+  }
+  record_change(scene, wall->points);
+}
+
+// Adds a polyline that stays as it is for the life of the scene. Returns false
+// if there is no room for it.
+bool scene_add_static(scene_t *scene, map_point_t points[], uint16_t n) {
+  if (scene->static_count >= SCENE_MAX_STATIC)
+    return false;
+
+  scene_static_t *shape = &scene->statics[scene->static_count++];
+  shape->points = points;
+  shape->n = n;
+  shape->bounds = find_bounds(points, n);
+
+  if (scene->grid)
+    renderer_grid_add_polygon(scene->grid, points, n);
+  return true;
+}
+
+static scene_wall_t *find_wall(scene_t *scene, scene_handle_t handle) {
+  if (handle < 0 || handle >= SCENE_MAX_WALLS ||
+      scene->slots[handle] == SCENE_NO_WALL)
+    return NULL;
+
+  return &scene->walls[scene->slots[handle]];
+}
+
+// Returns SCENE_NO_WALL if the scene is full.
+scene_handle_t scene_add_wall(scene_t *scene, map_point_t *p1,
+                              map_point_t *p2) {
+  if (scene->free_count == 0)
+    return SCENE_NO_WALL;
+
+  scene_handle_t handle = scene->free_handles[--scene->free_count];
+  scene->slots[handle] = scene->count;
+
+  scene_wall_t *wall = &scene->walls[scene->count++];
+  wall->handle = handle;
+  place_wall(scene, wall, p1, p2);
+  return handle;
+}
+
+// Adds each side of the polygon as its own wall.
+void scene_add_polygon(scene_t *scene, map_point_t points[], uint16_t n) {
+  for (uint16_t i = 1; i < n; i++)
+    scene_add_wall(scene, &points[i - 1], &points[i]);
+}
+
+void scene_remove_wall(scene_t *scene, scene_handle_t handle) {
+  scene_wall_t *wall = find_wall(scene, handle);
+  if (!wall)
+    return;
+
+  unplace_wall(scene, wall);
+
+  scene_wall_t *last = &scene->walls[--scene->count];
+  if (wall != last) {
+    *wall = *last;
+    scene->slots[wall->handle] = scene->slots[handle];
+  }
+
+  scene->slots[handle] = SCENE_NO_WALL;
+  scene->free_handles[scene->free_count++] = handle;
+}
+
+void scene_move_wall(scene_t *scene, scene_handle_t handle, map_point_t *p1,
+                     map_point_t *p2) {
+  scene_wall_t *wall = find_wall(scene, handle);
+  if (!wall)
+    return;
+
+  unplace_wall(scene, wall);
+  place_wall(scene, wall, p1, p2);
+}
+
+static bool in_view(frame_t *frame, scene_bounds_t *bounds) {
+  map_point_t *camera = &frame->camera;
+  return bounds->max_tile_x >= camera->tile_x - VIEW_TILES &&
+         bounds->min_tile_x <= camera->tile_x + VIEW_TILES &&
+         bounds->max_tile_y >= camera->tile_y - VIEW_TILES &&
+         bounds->min_tile_y <= camera->tile_y + VIEW_TILES;
+}
+
+void scene_render(scene_t *scene, frame_t *frame) {
+#ifdef RENDERER_GRID
+  if (scene->grid) {
+    renderer_render_grid(frame, scene->grid);
+    return;
+  }
+#endif
+
+  for (uint8_t i = 0; i < scene->static_count; i++) {
+    scene_static_t *shape = &scene->statics[i];
+    if (in_view(frame, &shape->bounds))
+      renderer_render_polygon(frame, shape->points, shape->n);
+  }
+
+  for (uint16_t i = 0; i < scene->count; i++) {
+    scene_wall_t *wall = &scene->walls[i];
+    if (in_view(frame, &wall->bounds))
+      renderer_render_polygon(frame, wall->points, 2);
+  }
+}
+
+static bool change_columns(scene_t *scene, frame_t *frame, map_point_t points[],
+                           int16_t *start, int16_t *end) {
+#ifdef RENDERER_GRID
+  if (scene->grid)
+    return renderer_grid_wall_columns(frame, scene->grid, points, start, end);
+#else
+  (void)scene;
+#endif
+  return renderer_wall_columns(frame, points, start, end);
+}
+
+// Brings a frame rendered before the latest changes up to date, rendering only
+// the columns the changed walls covered or cover now.
+void scene_patch_frame(scene_t *scene, frame_t *frame) {
+  int16_t start = FRAME_WIDTH, end = -1;
+
+  if (scene->changes_overflowed) {
+    start = 0;
+    end = FRAME_WIDTH - 1;
+  } else {
+    for (uint8_t i = 0; i < scene->change_count; i++) {
+      int16_t wall_start, wall_end;
+      if (!change_columns(scene, frame, scene->changes[i], &wall_start,
+                          &wall_end))
+        continue;
+
+      if (wall_start < start)
+        start = wall_start;
+      if (wall_end > end)
+        end = wall_end;
+    }
+  }
+
+  if (start > end)
+    return;
+
+  renderer_begin_columns(frame, start, end);
+  scene_render(scene, frame);
+  renderer_end_columns(frame);
+}
+
+void scene_clear_changes(scene_t *scene) {
+  scene->change_count = 0;
+  scene->changes_overflowed = false;
+}
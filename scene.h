@@ -0,0 +1,71 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "renderer.h"
+
+#define SCENE_MAX_WALLS 128
+#define SCENE_MAX_STATIC 16 // Polylines that never change
+
+// Changes remembered for patching frames that were already rendered. Past
+// this many, patched frames are rendered again in full.
+#define SCENE_MAX_CHANGES 8
+
+#define SCENE_NO_WALL -1
+
+typedef int16_t scene_handle_t;
+
+typedef struct {
+  int16_t min_tile_x, min_tile_y;
+  int16_t max_tile_x, max_tile_y;
+} scene_bounds_t;
+
+typedef struct {
+  map_point_t points[2];
+  scene_bounds_t bounds; // For culling
+  scene_handle_t handle;
+} scene_wall_t;
+
+// Kept whole, so the points walls share are only transformed once.
+typedef struct {
+  map_point_t *points; // Not copied, so must outlive the scene
+  uint16_t n;
+  scene_bounds_t bounds;
+} scene_static_t;
+
+typedef struct {
+  scene_static_t statics[SCENE_MAX_STATIC];
+  uint8_t static_count;
+
+  // Live walls are packed at the front so rendering never skips over holes.
+  // Removing one moves the last wall into its place.
+  scene_wall_t walls[SCENE_MAX_WALLS];
+  uint16_t count;
+
+  int16_t slots[SCENE_MAX_WALLS]; // Index into `walls` of each handle
+  scene_handle_t free_handles[SCENE_MAX_WALLS];
+  uint16_t free_count;
+
+  // Where walls were added, removed or moved since `scene_clear_changes`
+  map_point_t changes[SCENE_MAX_CHANGES][2];
+  uint8_t change_count;
+  bool changes_overflowed;
+
+  grid_map_t *grid; // Kept up to date with the walls, unless NULL
+} scene_t;
+
+void scene_init(scene_t *scene, grid_map_t *grid);
+bool scene_add_static(scene_t *scene, map_point_t points[], uint16_t n);
+scene_handle_t scene_add_wall(scene_t *scene, map_point_t *p1,
+                              map_point_t *p2);
+void scene_add_polygon(scene_t *scene, map_point_t points[], uint16_t n);
+void scene_remove_wall(scene_t *scene, scene_handle_t handle);
+void scene_move_wall(scene_t *scene, scene_handle_t handle, map_point_t *p1,
+                     map_point_t *p2);
+void scene_render(scene_t *scene, frame_t *frame);
+void scene_patch_frame(scene_t *scene, frame_t *frame);
+void scene_clear_changes(scene_t *scene);
+
+#endif
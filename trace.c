@@ -0,0 +1,147 @@
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "intervalTimer.h"
+
+#define TRACE_TIMER INTERVAL_TIMER_1
+
+#if defined(TRACE_RECORD) || defined(TRACE_REPLAY)
+#define TRACE_ENABLED
+#endif
+
+#ifdef TRACE_ENABLED
+static float frame_times[TRACE_MAX_FRAMES];
+static uint16_t frames_done = 0;
+static uint16_t inputs_done = 0;
+#endif
+
+#ifdef TRACE_RECORD
+static trace_entry_t recorded[TRACE_MAX_FRAMES];
+#endif
+
+#ifdef TRACE_REPLAY
+static uint16_t hash_mismatches = 0;
+static int32_t first_mismatch = -1;
+#endif
+
+void trace_init() {
+#ifdef TRACE_ENABLED
+  intervalTimer_initCountUp(TRACE_TIMER);
+  intervalTimer_start(TRACE_TIMER);
+#endif
+}
+
+bool trace_done() {
+#if defined(TRACE_RECORD)
+  return inputs_done >= TRACE_MAX_FRAMES;
+#elif defined(TRACE_REPLAY)
+  return inputs_done >= trace_entry_count || inputs_done >= TRACE_MAX_FRAMES;
+#else
+  return false;
+#endif
+}
+
+void trace_frame_start() {
+#ifdef TRACE_ENABLED
+  intervalTimer_reload(TRACE_TIMER);
+#endif
+}
+
+void trace_frame_end(frame_t *frame) {
+#ifdef TRACE_ENABLED
+  frame_times[frames_done] =
+      intervalTimer_getTotalDurationInSeconds(TRACE_TIMER);
+  uint32_t hash = renderer_hash_frame(frame);
+
+#ifdef TRACE_RECORD
+  recorded[frames_done].frame_hash = hash;
+#else
+  if (hash != trace_entries[frames_done].frame_hash) {
+    if (first_mismatch < 0)
+      first_mismatch = frames_done;
+    hash_mismatches++;
+  }
+#endif
+
+  frames_done++;
+#endif
+}
+
+void trace_input(input_t *input) {
+#if defined(TRACE_RECORD)
+  recorded[inputs_done++].input = *input;
+#elif defined(TRACE_REPLAY)
+  *input = trace_entries[inputs_done++].input;
+#endif
+}
+
+#ifdef TRACE_ENABLED
+static int compare_times(const void *a, const void *b) {
+  float ta = *(const float *)a, tb = *(const float *)b;
+  return (ta > tb) - (ta < tb);
+}
+
+// Nearest-rank percentile of the (sorted) frame times.
+static float percentile(uint16_t pct) {
+  uint32_t rank = ((uint32_t)pct * frames_done + 99) / 100;
+  return frame_times[rank ? rank - 1 : 0];
+}
+#endif
+
+#ifdef TRACE_RECORD
+static void print_trace(float p99) {
+  printf("#include \"trace.h\"\n\n");
+  printf("const float trace_baseline_p99 = %f;\n\n", p99);
+  printf("const trace_entry_t trace_entries[] = {\n");
+  for (uint16_t i = 0; i < inputs_done; i++) {
+    const uint16_t *held = recorded[i].input.held;
+    printf("    {{{%d, %d, %d, %d}}, 0x%08lx},\n", held[0], held[1], held[2],
+           held[3], (unsigned long)recorded[i].frame_hash);
+  }
+  printf("};\n\n");
+  printf("const uint16_t trace_entry_count =\n");
+  printf("    sizeof(trace_entries) / sizeof(trace_entries[0]);\n");
+}
+#endif
+
+// Prints the frame time percentiles, and for a replay whether it matched the
+// recording. Returns false if the replay failed.
+bool trace_report() {
+#ifdef TRACE_ENABLED
+  if (frames_done == 0)
+    return true;
+
+  qsort(frame_times, frames_done, sizeof(frame_times[0]), compare_times);
+  float p99 = percentile(99);
+  printf("Frames: %d\n", frames_done);
+  printf("Frame time p50: %f, p90: %f, p99: %f, max: %f\n", percentile(50),
+         percentile(90), p99, frame_times[frames_done - 1]);
+
+#ifdef TRACE_RECORD
+  print_trace(p99);
+  return true;
+#else
+  bool passed = true;
+  if (hash_mismatches) {
+    printf("%d frames differ from the trace, first at frame %ld\n",
+           hash_mismatches, (long)first_mismatch);
+    passed = false;
+  }
+
+  if (trace_baseline_p99 <= 0) {
+    printf("p99 frame time not checked: the trace has no baseline\n");
+  } else if (p99 > trace_baseline_p99 * (1 + TRACE_P99_TOLERANCE)) {
+    printf("p99 frame time regressed: %f (trace: %f)\n", p99,
+           trace_baseline_p99);
+    passed = false;
+  }
+
+  printf(passed ? "TRACE PASS\n" : "TRACE FAIL\n");
+  return passed;
+#endif
+#else
+  return true;
+#endif
+}
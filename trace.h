@@ -0,0 +1,41 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "input.h"
+#include "renderer.h"
+
+// Uncomment one of these lines to record the button inputs of a run, or to
+// replay a recorded run instead of reading the buttons. Recording prints the
+// trace to the console in the format of trace_data.c once TRACE_MAX_FRAMES
+// ticks have gone by; paste it over that file to make it the new golden run.
+// Replaying re-renders the run, checks every frame against the recorded hash
+// and compares the frame times against the recorded ones.
+// #define TRACE_RECORD
+// #define TRACE_REPLAY
+
+#define TRACE_MAX_FRAMES 600 // 30 seconds at MIN_TIME_TICK
+
+// A replay fails if its p99 frame time is this much slower than the recording.
+#define TRACE_P99_TOLERANCE 0.10
+
+typedef struct {
+  input_t input;       // Input passed to `move` before the frame was rendered
+  uint32_t frame_hash; // `renderer_hash_frame` of the frame
+} trace_entry_t;
+
+// The golden run, defined in trace_data.c
+extern const trace_entry_t trace_entries[];
+extern const uint16_t trace_entry_count;
+extern const float trace_baseline_p99; // Seconds, 0 if not measured
+
+void trace_init();
+bool trace_done();
+void trace_frame_start();
+void trace_frame_end(frame_t *frame);
+void trace_input(input_t *input);
+bool trace_report();
+
+#endif
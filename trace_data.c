@@ -0,0 +1,195 @@
+#include "trace.h"
+
+// Scripted drive around the maze: forward, turning in both directions and
+// backing up, recorded on a host build rather than the board.
+//
+// THE P99 FRAME TIME GATE IS OFF for this trace: host frame times say nothing
+// about the board, so the baseline is 0 and a replay only checks the frame
+// hashes. Record the trace on the board with TRACE_RECORD to turn it on.
+const float trace_baseline_p99 = 0;
+
+const trace_entry_t trace_entries[] = {
+    {{{0, 0, 0, 0}}, 0x334a0b95},
+    {{{0, 0, 0, 53}}, 0x053342c0},
+    {{{0, 0, 0, 55}}, 0x3986a415},
+    {{{0, 0, 0, 56}}, 0xe717f08b},
+    {{{0, 0, 0, 55}}, 0x8257b9e9},
+    {{{0, 0, 0, 55}}, 0xdbb4e45c},
+    {{{0, 0, 0, 55}}, 0x69f6382d},
+    {{{0, 0, 0, 55}}, 0x41132c2b},
+    {{{0, 0, 0, 55}}, 0x662eeef8},
+    {{{0, 0, 0, 55}}, 0x424e9ffe},
+    {{{0, 0, 0, 55}}, 0xbdc1c729},
+    {{{0, 0, 0, 55}}, 0x36f8a763},
+    {{{0, 0, 0, 55}}, 0xf65d6993},
+    {{{0, 0, 0, 55}}, 0x2c91693d},
+    {{{0, 0, 0, 55}}, 0xc60a836a},
+    {{{0, 0, 0, 55}}, 0x6b172aff},
+    {{{0, 0, 0, 55}}, 0x17f06a68},
+    {{{0, 0, 0, 55}}, 0xbc1fb450},
+    {{{0, 0, 0, 55}}, 0xa26ec485},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 54}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 0, 0, 55}}, 0x09d6a1c5},
+    {{{0, 54, 0, 1}}, 0x09d6a1c5},
+    {{{0, 55, 0, 0}}, 0x09d6a1c5},
+    {{{0, 55, 0, 0}}, 0x09d6a1c5},
+    {{{0, 55, 0, 0}}, 0x09d6a1c5},
+    {{{0, 55, 0, 0}}, 0x09d6a1c5},
+    {{{0, 55, 0, 0}}, 0x09d6a1c5},
+    {{{0, 55, 0, 0}}, 0x09d6a1c5},
+    {{{0, 55, 0, 0}}, 0x09d6a1c5},
+    {{{0, 55, 0, 0}}, 0xcd01347d},
+    {{{0, 55, 0, 0}}, 0x9414d6a5},
+    {{{0, 55, 0, 0}}, 0xdff71505},
+    {{{0, 55, 0, 0}}, 0xfb2d5dbd},
+    {{{0, 55, 0, 0}}, 0xb2d038fd},
+    {{{0, 55, 0, 0}}, 0xea5b2ba5},
+    {{{0, 55, 0, 0}}, 0x431d7b9d},
+    {{{0, 55, 0, 0}}, 0x46e496fd},
+    {{{0, 55, 0, 0}}, 0x1d40272f},
+    {{{0, 55, 0, 0}}, 0x820544ab},
+    {{{0, 55, 0, 0}}, 0x81f45e41},
+    {{{0, 55, 0, 0}}, 0x470443b6},
+    {{{0, 56, 0, 55}}, 0x77129285},
+    {{{0, 55, 0, 55}}, 0x71b744e5},
+    {{{0, 55, 0, 55}}, 0xc5b952fd},
+    {{{0, 55, 0, 55}}, 0x87440a7d},
+    {{{0, 55, 0, 55}}, 0xfb40d5bd},
+    {{{0, 55, 0, 55}}, 0xc96dbd1d},
+    {{{0, 55, 0, 55}}, 0x42cc1cc5},
+    {{{0, 55, 0, 55}}, 0x31cb60e5},
+    {{{0, 55, 0, 55}}, 0x1f286e5d},
+    {{{0, 55, 0, 55}}, 0x14241265},
+    {{{0, 55, 0, 55}}, 0xc4d0171d},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x2eff4933},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 55, 0, 55}}, 0x8abdadc5},
+    {{{0, 45, 10, 45}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0x8abdadc5},
+    {{{0, 0, 55, 0}}, 0xdb90ef7f},
+    {{{0, 0, 55, 0}}, 0x600625ed},
+    {{{0, 0, 55, 0}}, 0xda735540},
+    {{{0, 0, 55, 0}}, 0x0256dd0c},
+    {{{0, 0, 55, 0}}, 0x6f75b4ca},
+    {{{0, 0, 55, 0}}, 0xd831252e},
+    {{{0, 0, 55, 0}}, 0x0a7b8c1d},
+    {{{0, 0, 55, 0}}, 0x439d451a},
+    {{{0, 0, 55, 0}}, 0x491d05be},
+    {{{10, 0, 45, 0}}, 0xc760f4af},
+    {{{55, 0, 0, 0}}, 0x26b21340},
+    {{{55, 0, 0, 0}}, 0xd9bdb934},
+    {{{55, 0, 0, 0}}, 0x16f6f208},
+    {{{55, 0, 0, 0}}, 0xa81fbce8},
+    {{{55, 0, 0, 0}}, 0x6e163289},
+    {{{55, 0, 0, 0}}, 0x8ee85677},
+    {{{55, 0, 0, 0}}, 0xbd8a9b33},
+    {{{55, 0, 0, 0}}, 0x758a5c3a},
+    {{{55, 0, 0, 0}}, 0xa8a2f450},
+    {{{55, 0, 0, 0}}, 0x91334689},
+    {{{55, 0, 0, 0}}, 0xad9fefc6},
+    {{{55, 0, 0, 0}}, 0x10b5ed50},
+    {{{55, 0, 0, 0}}, 0xe5f6c684},
+    {{{55, 0, 0, 0}}, 0x8abdadc5},
+    {{{55, 0, 0, 0}}, 0x8abdadc5},
+    {{{55, 0, 0, 0}}, 0x8abdadc5},
+    {{{55, 0, 0, 0}}, 0x8abdadc5},
+    {{{55, 0, 0, 0}}, 0x8abdadc5},
+    {{{55, 0, 0, 0}}, 0x8abdadc5},
+    {{{55, 0, 0, 0}}, 0x8abdadc5},
+    {{{55, 0, 0, 0}}, 0x386c363d},
+    {{{55, 0, 0, 0}}, 0x45ae3e9d},
+    {{{55, 0, 0, 0}}, 0x25301e05},
+    {{{55, 0, 0, 0}}, 0xeee980bd},
+    {{{55, 0, 0, 0}}, 0x7d34b8a5},
+    {{{55, 0, 0, 0}}, 0xdcd9f5dd},
+    {{{55, 0, 0, 0}}, 0x1f286e5d},
+    {{{55, 0, 0, 0}}, 0x81297745},
+    {{{55, 0, 0, 0}}, 0xe7d81f5d},
+    {{{55, 0, 0, 0}}, 0x020c2e85},
+    {{{55, 0, 0, 0}}, 0x01fd687d},
+    {{{55, 0, 0, 0}}, 0xc96dbd1d},
+    {{{55, 0, 0, 0}}, 0x50c4397d},
+    {{{55, 0, 0, 0}}, 0x46a11925},
+    {{{55, 0, 0, 0}}, 0x407dcec5},
+    {{{55, 0, 0, 0}}, 0x391ce865},
+    {{{55, 0, 0, 0}}, 0xc890e35d},
+    {{{55, 0, 0, 0}}, 0xd4b9e165},
+    {{{55, 0, 0, 0}}, 0xb53d945d},
+    {{{55, 0, 0, 10}}, 0x9a818d45},
+    {{{55, 0, 0, 55}}, 0x5283455d},
+    {{{55, 0, 0, 55}}, 0x8ee92abd},
+    {{{55, 0, 0, 55}}, 0xca8bb53d},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{54, 0, 0, 54}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{55, 0, 0, 55}}, 0x09d6a1c5},
+    {{{1, 0, 0, 1}}, 0x09d6a1c5},
+    {{{0, 0, 0, 0}}, 0x09d6a1c5},
+    {{{0, 0, 0, 0}}, 0x09d6a1c5},
+    {{{0, 0, 0, 0}}, 0x09d6a1c5},
+    {{{0, 0, 0, 0}}, 0x09d6a1c5},
+    {{{0, 0, 0, 0}}, 0x09d6a1c5},
+    {{{0, 0, 0, 0}}, 0x09d6a1c5},
+    {{{0, 0, 0, 0}}, 0x09d6a1c5},
+    {{{0, 0, 0, 0}}, 0x09d6a1c5},
+};
+
+const uint16_t trace_entry_count =
+    sizeof(trace_entries) / sizeof(trace_entries[0]);